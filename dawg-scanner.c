@@ -0,0 +1,172 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+#include <pthread.h>
+
+#include "dawg-scanner.h"
+#include "dawg-file-traversal.h"
+
+// don't split text into pieces smaller than this when scanning in parallel
+#define MIN_BYTES_PER_THREAD (64 * 1024)
+
+// index of a byte of text in the alphabet, or -1 if it isn't a letter
+static inline int _letter_index(unsigned char c) {
+	if (c >= 'A' && c <= 'Z') {
+		c += 'a' - 'A';
+	}
+	int index = char_to_index(c);
+	return index >= 0 && index < LETTER_COUNT ? index : -1;
+}
+
+void dawg_scanner_init(struct dawg_scanner * scanner, const unsigned int * table, int boundaries,
+					   dawg_match_callback on_match, void * user_data) {
+	assert(table && on_match);
+	memset(scanner, 0, sizeof(struct dawg_scanner));
+	scanner->table = table;
+	scanner->boundaries = boundaries;
+	scanner->on_match = on_match;
+	scanner->user_data = user_data;
+	scanner->spawn_limit = SIZE_MAX;
+}
+
+void _report_pending_matches(struct dawg_scanner * scanner) {
+	for (int i=0; i<scanner->pending_count; i++) {
+		size_t start = scanner->pending_starts[i];
+		scanner->on_match(start, scanner->position - start, scanner->user_data);
+	}
+	scanner->pending_count = 0;
+}
+
+void dawg_scan(struct dawg_scanner * scanner, const char * text, size_t length) {
+	const unsigned int * table = scanner->table;
+	int match_start = scanner->boundaries & SCAN_WORD_START;
+	int match_end = scanner->boundaries & SCAN_WORD_END;
+
+	for (size_t i=0; i<length; i++, scanner->position++) {
+		int index = _letter_index(text[i]);
+		if (index < 0) {
+			// a boundary: confirm waiting matches and kill all states
+			_report_pending_matches(scanner);
+			scanner->state_count = 0;
+			scanner->previous_is_letter = 0;
+			continue;
+		}
+		// matches waiting for a boundary were followed by a letter
+		scanner->pending_count = 0;
+
+		// start a new state at the root. A state can't live for more than WORD_LIMIT letters, so
+		// there is always room unless the table is corrupt
+		if ((!match_start || !scanner->previous_is_letter) && scanner->position < scanner->spawn_limit
+			&& scanner->state_count < WORD_LIMIT) {
+			scanner->state_offsets[scanner->state_count] = 0;
+			scanner->state_starts[scanner->state_count] = scanner->position;
+			scanner->state_count++;
+		}
+
+		// advance every live state by one letter, dropping those that can't continue
+		int live = 0;
+		for (int s=0; s<scanner->state_count; s++) {
+			unsigned int offset = scanner->state_offsets[s];
+			unsigned int edge;
+			int value;
+			do {
+				edge = table[offset++];
+				value = edge_value(edge);
+			} while (value < index && !is_last_edge(edge)); // siblings are sorted by value
+			if (value != index) {
+				continue;
+			}
+			size_t start = scanner->state_starts[s];
+			if (is_word_edge(edge)) {
+				if (match_end) {
+					scanner->pending_starts[scanner->pending_count++] = start;
+				} else {
+					scanner->on_match(start, scanner->position + 1 - start, scanner->user_data);
+				}
+			}
+			if (edge_offset(edge)) {
+				scanner->state_offsets[live] = edge_offset(edge);
+				scanner->state_starts[live] = start;
+				live++;
+			}
+		}
+		scanner->state_count = live;
+		scanner->previous_is_letter = 1;
+	}
+}
+
+void dawg_scan_finish(struct dawg_scanner * scanner) {
+	_report_pending_matches(scanner);
+	scanner->state_count = 0;
+	scanner->previous_is_letter = 0;
+}
+
+//
+// PARALLEL SCANNING
+//
+
+// Text is split into one region per thread. Each thread reports the matches that start in its
+// region, scanning on past the end of the region until those matches are complete.
+
+struct _scan_job {
+	struct dawg_scanner scanner;
+	const char * text;
+	size_t length; // length of the whole text
+	size_t begin, end; // region of the text that this job starts matches in
+	pthread_t thread;
+	int started; // whether thread is running
+};
+
+void * _run_scan_job(void * arg) {
+	struct _scan_job * job = arg;
+	struct dawg_scanner * scanner = &job->scanner;
+	scanner->position = job->begin;
+	scanner->spawn_limit = job->end;
+	scanner->previous_is_letter = job->begin > 0 && _letter_index(job->text[job->begin - 1]) >= 0;
+
+	dawg_scan(scanner, job->text + job->begin, job->end - job->begin);
+	while (scanner->position < job->length && (scanner->state_count || scanner->pending_count)) {
+		dawg_scan(scanner, job->text + scanner->position, 1);
+	}
+	if (scanner->position == job->length) {
+		dawg_scan_finish(scanner);
+	}
+	return 0;
+}
+
+void dawg_scan_parallel(const unsigned int * table, const char * text, size_t length, int boundaries,
+						int thread_count, dawg_match_callback on_match, void * user_data) {
+	if (thread_count > length / MIN_BYTES_PER_THREAD) {
+		thread_count = length / MIN_BYTES_PER_THREAD;
+	}
+	if (thread_count < 1) {
+		thread_count = 1;
+	}
+
+	struct _scan_job * jobs = calloc(thread_count, sizeof(struct _scan_job));
+	for (int i=0; i<thread_count; i++) {
+		struct _scan_job * job = &jobs[i];
+		dawg_scanner_init(&job->scanner, table, boundaries, on_match, user_data);
+		job->text = text;
+		job->length = length;
+		job->begin = length / thread_count * i;
+		job->end = i == thread_count - 1 ? length : length / thread_count * (i + 1);
+	}
+
+	// the calling thread takes the first region itself
+	for (int i=1; i<thread_count; i++) {
+		jobs[i].started = pthread_create(&jobs[i].thread, 0, _run_scan_job, &jobs[i]) == 0;
+		if (!jobs[i].started) {
+			_run_scan_job(&jobs[i]);
+		}
+	}
+	_run_scan_job(&jobs[0]);
+	for (int i=1; i<thread_count; i++) {
+		if (jobs[i].started) {
+			pthread_join(jobs[i].thread, 0);
+		}
+	}
+
+	free(jobs);
+}
@@ -0,0 +1,65 @@
+/*
+ *  dawg-scanner.h
+ *
+ *  Functions for finding every dictionary word in a stream of text using a binary DAWG
+ */
+
+#ifndef dawg_scanner_h_included
+#define dawg_scanner_h_included
+
+#include <stdio.h>
+#include <stddef.h>
+
+#include "mutable-dawg.h"
+
+// word boundary rules. Letters are the bytes accepted by char_to_index, in either case; every other
+// byte, and the start and end of the stream, is a word boundary
+#define SCAN_ANYWHERE 0 // report every match, including those inside longer words
+#define SCAN_WORD_START 1 // only report matches that start at a word boundary
+#define SCAN_WORD_END 2 // only report matches that end at a word boundary
+#define SCAN_WHOLE_WORDS (SCAN_WORD_START | SCAN_WORD_END)
+
+// called for each match. start is the position of its first byte counted from the start of the stream
+typedef void (*dawg_match_callback)(size_t start, size_t length, void * user_data);
+
+// A scanner keeps one traversal state for each position in the last WORD_LIMIT bytes at which a
+// dictionary word could have started. Each byte of text is fed to all live states in one pass,
+// and a match is reported whenever a state crosses a word edge.
+struct dawg_scanner {
+	const unsigned int * table; // contents of a CDAWG file, e.g. mmap'd
+	int boundaries; // combination of the SCAN_* flags
+	dawg_match_callback on_match;
+	void * user_data;
+
+	size_t position; // number of bytes consumed so far
+	size_t spawn_limit; // no matches are started at or after this position
+	int previous_is_letter;
+
+	// live states: offset in table of the next sibling list to search, and the start of the match
+	int state_count;
+	unsigned int state_offsets[WORD_LIMIT];
+	size_t state_starts[WORD_LIMIT];
+
+	// with SCAN_WORD_END, matches ending on the previous byte wait here until the next byte shows
+	// whether they end at a word boundary
+	int pending_count;
+	size_t pending_starts[WORD_LIMIT];
+};
+
+// prepare a scanner to read a new stream
+void dawg_scanner_init(struct dawg_scanner * scanner, const unsigned int * table, int boundaries,
+					   dawg_match_callback on_match, void * user_data);
+
+// feed the next chunk of the stream to a scanner. Matches may span chunks, and nothing is copied,
+// so it is best to pass chunks as large as possible
+void dawg_scan(struct dawg_scanner * scanner, const char * text, size_t length);
+
+// signal the end of the stream, reporting any matches that were waiting for a word boundary
+void dawg_scan_finish(struct dawg_scanner * scanner);
+
+// scan the whole of text, splitting it between thread_count threads. on_match is called from
+// several threads at once, and matches are not reported in order
+void dawg_scan_parallel(const unsigned int * table, const char * text, size_t length, int boundaries,
+						int thread_count, dawg_match_callback on_match, void * user_data);
+
+#endif
@@ -1,4 +1,5 @@
 #include <stdio.h>
+#include <string.h>
 #include <strings.h>
 #include <assert.h>
 #include <math.h>
@@ -8,15 +9,26 @@
 
 void usage(const char * execName) {
 	fprintf(stderr, "Directed Acyclic Word Graph compiler\n\n");
-	fprintf(stderr, "Usage: %s OPTION\n\n", execName);
+	fprintf(stderr, "Usage: %s OPTION [FILES]\n\n", execName);
 	fprintf(stderr, "Where OPTION is one of:\n");
 	fprintf(stderr, " -c, --compile      Read a dictionary, one word per line in alphabetical order\n");
 	fprintf(stderr, "                    from the standard input and output a CDAWG file to the\n");
 	fprintf(stderr, "                    standard output\n");
-	fprintf(stderr, " -e, --embed        As per --compile, but output the binary data as a C source\n");
-	fprintf(stderr, "                    code containing an array literal\n");
+	fprintf(stderr, " -e, --embed        As per --compile, but output the binary data as a C/C++\n");
+	fprintf(stderr, "                    header containing a constant array and lookup functions\n");
+	fprintf(stderr, " -m, --multi FILE...\n");
+	fprintf(stderr, "                    Read up to %d dictionaries, one word per line in\n", MAX_DICTIONARIES);
+	fprintf(stderr, "                    alphabetical order, from the named files and output a single\n");
+	fprintf(stderr, "                    multi-dictionary CDAWG file recording which dictionaries\n");
+	fprintf(stderr, "                    contain each word to the standard output. Dictionaries are\n");
+	fprintf(stderr, "                    numbered from 0 in the order they are named\n");
 	fprintf(stderr, " -d, --decompile    Read a CDAWG file from the standard input and output the\n");
 	fprintf(stderr, "                    corresponding dictionary to the standard output\n");
+	fprintf(stderr, " -u, --update ADDED REMOVED\n");
+	fprintf(stderr, "                    Read a CDAWG file from the standard input, add the words in\n");
+	fprintf(stderr, "                    the file ADDED and remove the words in the file REMOVED (one\n");
+	fprintf(stderr, "                    word per line in any order) and output the updated CDAWG file\n");
+	fprintf(stderr, "                    to the standard output\n");
 	fprintf(stderr, " -g, --graphviz     Read a CDAWG file from the standard input and output a\n");
 	fprintf(stderr, "                    graph description suitable for loading into graphviz\n");
 }
@@ -88,12 +100,19 @@ int main (int argc, const char * argv[]) {
 	
 	
 	
-	if (argc != 2) {
+	if (argc < 2) {
 		usage(argv[0]);
 		return 1;
 	}
 	
 	const char * cmd = argv[1];
+	int is_update = strcmp("-u", cmd) == 0 || strcmp("--update", cmd) == 0;
+	int is_multi = strcmp("-m", cmd) == 0 || strcmp("--multi", cmd) == 0;
+	
+	if (is_multi ? argc < 3 || argc - 2 > MAX_DICTIONARIES : argc != (is_update ? 4 : 2)) {
+		usage(argv[0]);
+		return 1;
+	}
 	
 	if (strcmp("-c", cmd) == 0 || strcmp("--compile", cmd) == 0) {
 		struct dawg * dawg = dawg_from_word_file(stdin);
@@ -107,12 +126,40 @@ int main (int argc, const char * argv[]) {
 		return 0;
 	}
 	
+	if (is_multi) {
+		FILE * dicts[MAX_DICTIONARIES];
+		for (int i=2; i<argc; i++) {
+			dicts[i - 2] = fopen(argv[i], "r");
+			if (!dicts[i - 2]) {
+				fprintf(stderr, "Fatal error: could not open \"%s\"\n", argv[i]);
+				return 1;
+			}
+			fprintf(stderr, "Dictionary %d: %s\n", i - 2, argv[i]);
+		}
+		struct dawg * dawg = dawg_from_word_files(dicts, argc - 2);
+		multi_binary_file_from_dawg(dawg, stdout);
+		return 0;
+	}
+	
 	if (strcmp("-d", cmd) == 0 || strcmp("--decompile", cmd) == 0) {
 		struct vertex * trie = trie_from_binary_file(stdin);
 		print_word_file(trie, stdout);
 		return 0;
 	}
 	
+	if (is_update) {
+		FILE * added = fopen(argv[2], "r");
+		FILE * removed = fopen(argv[3], "r");
+		if (!added || !removed) {
+			fprintf(stderr, "Fatal error: could not open \"%s\"\n", added ? argv[3] : argv[2]);
+			return 1;
+		}
+		struct dawg * dawg = dawg_from_binary_file(stdin);
+		update_dawg(dawg, added, removed);
+		binary_file_from_dawg(dawg, stdout, 0);
+		return 0;
+	}
+	
 	if (strcmp("-g", cmd) == 0 || strcmp("--graphviz", cmd) == 0) {
 		struct dawg * dawg = dawg_from_word_file(stdin);
 		graphviz_from_node(dawg->root, stdout);
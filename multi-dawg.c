@@ -0,0 +1,58 @@
+#include <stdio.h>
+#include <assert.h>
+
+#include "multi-dawg.h"
+#include "mutable-dawg.h"
+#include "dawg-file-traversal.h"
+
+int multi_dawg_from_buffer(struct multi_dawg * dawg, const unsigned int * buffer, size_t length) {
+	if (length < 1 || length != 1 + (size_t) buffer[0] * 3) {
+		return 0;
+	}
+	dawg->edge_count = buffer[0];
+	dawg->edges = buffer + 1;
+	dawg->word_masks = dawg->edges + dawg->edge_count;
+	dawg->reach_masks = dawg->word_masks + dawg->edge_count;
+	return 1;
+}
+
+// follow the path of word, keeping only the dictionaries in mask, and return the dictionaries
+// that contain it
+unsigned int _multi_dawg_lookup(const struct multi_dawg * dawg, const char * word, unsigned int mask) {
+	if (!word[0] || !dawg->edge_count) {
+		return 0;
+	}
+	unsigned int offset = 0, position = 0;
+	for (int i=0; word[i]; i++) {
+		if (i > 0) {
+			offset = edge_offset(dawg->edges[position]);
+			if (!offset) {
+				return 0;
+			}
+		}
+		int index = char_to_index(word[i]);
+		unsigned int edge;
+		do {
+			assert(offset < dawg->edge_count);
+			edge = dawg->edges[offset++];
+		} while (edge_value(edge) < index && !is_last_edge(edge)); // siblings are sorted by value
+		if (edge_value(edge) != index) {
+			return 0;
+		}
+		position = offset - 1;
+		mask &= dawg->reach_masks[position];
+		if (!mask) {
+			return 0;
+		}
+	}
+	return mask & dawg->word_masks[position];
+}
+
+unsigned int multi_dawg_membership(const struct multi_dawg * dawg, const char * word) {
+	return _multi_dawg_lookup(dawg, word, ~0u);
+}
+
+int multi_dawg_contains(const struct multi_dawg * dawg, const char * word, int dict_id) {
+	assert(dict_id >= 0 && dict_id < MAX_DICTIONARIES);
+	return _multi_dawg_lookup(dawg, word, 1u << dict_id) ? 1 : 0;
+}
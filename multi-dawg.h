@@ -0,0 +1,39 @@
+/*
+ *  multi-dawg.h
+ *
+ *  Functions for looking up words in binary DAWGs shared between several dictionaries, created
+ *  by dawgc --multi
+ */
+
+#ifndef multi_dawg_h_included
+#define multi_dawg_h_included
+
+#include <stddef.h>
+
+// A multi-dictionary file is laid out as:
+//
+// edge count: a 32 bit integer
+// edges: the edges, in the same format as a CDAWG file (see dawg-file-traversal.h)
+// word masks: one 32 bit integer per edge. Bit N is set if dictionary N contains the word
+//             ending at the edge
+// reach masks: one 32 bit integer per edge. Bit N is set if dictionary N contains any word
+//              whose path passes through the edge
+struct multi_dawg {
+	unsigned int edge_count;
+	const unsigned int * edges;
+	const unsigned int * word_masks;
+	const unsigned int * reach_masks;
+};
+
+// point a multi_dawg at the contents of a multi-dictionary file, which is not copied so it can
+// be mmap'd. length is the number of 32 bit integers in buffer. Returns 0 if the buffer is not a
+// valid multi-dictionary file, otherwise 1
+int multi_dawg_from_buffer(struct multi_dawg * dawg, const unsigned int * buffer, size_t length);
+
+// returns a bitmask of the dictionaries that contain word
+unsigned int multi_dawg_membership(const struct multi_dawg * dawg, const char * word);
+
+// returns 1 if dictionary dict_id contains word, otherwise 0
+int multi_dawg_contains(const struct multi_dawg * dawg, const char * word, int dict_id);
+
+#endif
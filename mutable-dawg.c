@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <strings.h>
 #include <ctype.h>
 #include <assert.h>
@@ -16,11 +17,13 @@
 a->hashcode == b->hashcode && \
 a->value == b->value && \
 a->is_word == b->is_word && \
+a->word_mask == b->word_mask && \
 memcmp(a->edges, b->edges, LETTER_COUNT * (int) sizeof(void*)) == 0)
 
 void _calculate_hashcode(struct vertex * node) {
 	int hash = node->value ^ (node->value << 5) ^ (node->value << 10) ^ (node->value << 15) ^ (node->value << 20) ^ (node->value << 25);
 	hash += node->is_word;
+	hash ^= node->word_mask;
 	
 	int * children_as_ints = (int*) node->edges;
 	int len = (sizeof(void*) * LETTER_COUNT) / sizeof(int); // number of integers worth of data in node.children
@@ -55,6 +58,11 @@ struct _dawg_context {
 	// offset[X] stores i+1 where i is the position in 'nodes' of the last node with leaf_distance == X
 	int offsets[WORD_LIMIT];
 	struct vertex ** nodes;
+	
+	// hash table of unique vertices, used while updating an existing dawg
+	struct vertex ** vertex_register;
+	int register_size;
+	int register_used; // number of slots containing a vertex or a tombstone
 };
 
 struct vertex * _new_node(unsigned char value, struct vertex * parent, struct _dawg_context * context) {
@@ -65,7 +73,7 @@ struct vertex * _new_node(unsigned char value, struct vertex * parent, struct _d
 	return n;
 }
 
-void _add_word_to_dawg(struct vertex * root, char * word, char * last_word, struct _dawg_context * context) {
+void _add_word_to_dawg(struct vertex * root, char * word, char * last_word, unsigned int word_mask, struct _dawg_context * context) {
 	if (last_word[0] && strcmp(word, last_word) < 0) {
 		fprintf(stderr, "Fatal error: words out of alphabetical order: \"%s\" then \"%s\"\n", last_word, word);
 		exit(1);
@@ -87,6 +95,7 @@ void _add_word_to_dawg(struct vertex * root, char * word, char * last_word, stru
 		}
 	}
 	node->is_word = 1;
+	node->word_mask |= word_mask;
 	strcpy(last_word, word);
 }
 
@@ -204,44 +213,93 @@ int _convert_trie_to_dawg(struct vertex * root, struct _dawg_context * context)
 	return merged;
 }
 
+// read the next line of a word file into word, converting it to lower case. Returns 0 at the end
+// of the file, -1 if the line doesn't contain a valid word and 1 otherwise
+int _read_word(FILE * in, char * word, int size, int * lineNo) {
+	if (!fgets(word, size, in)) {
+		return 0;
+	}
+	if (word[strlen(word) - 1] != '\n' && !feof(in)) { // word was too long
+		fprintf(stderr, "Skipping line %d. Word is longer than %d characters\n", *lineNo, WORD_LIMIT);
+		do {
+			fgets(word, size, in);
+		} while (word[strlen(word) - 1] != '\n');
+		return -1;
+	}
+	(*lineNo)++;
+	for (int i=0; word[i]; i++) {
+		if (isspace(word[i])) {
+			word[i] = '\0';
+		} else if (isupper(word[i])) {
+			word[i] = tolower(word[i]);
+		} else if (!islower(word[i])) {
+			fprintf(stderr, "Skipping line %d: \"%s\". Illegal character '%c' at position %d\n", *lineNo, word, word[i], i);
+			return -1;
+		}
+	}
+	if (strlen(word) > WORD_LIMIT) {
+		fprintf(stderr, "Skipping line %d: \"%s\". Word is longer than %d characters\n", *lineNo, word, WORD_LIMIT);
+		return -1;
+	}
+	return 1;
+}
+
+// read the next valid word from a word file, skipping invalid lines. Returns 0 at the end of the file
+int _read_next_word(FILE * in, char * word, int size, int * lineNo) {
+	int result;
+	do {
+		result = _read_word(in, word, size, lineNo);
+	} while (result < 0);
+	return result;
+}
+
 struct dawg * dawg_from_word_file(FILE *dict) {
-	assert(dict);
+	return dawg_from_word_files(&dict, 1);
+}
+
+struct dawg * dawg_from_word_files(FILE ** dicts, int dict_count) {
+	assert(dict_count > 0 && dict_count <= MAX_DICTIONARIES);
 	
 	struct _dawg_context context;
 	memset(&context, 0, sizeof(context));
 	
-	// read file line by line, adding words into a trie
+	// read the files line by line in step, adding each word into a trie with the bits of all the
+	// files it appears in
 	char last_word[WORD_BUFF_SIZE];
 	set0(last_word);
-	char word[256];
-	set0(word);
+	char words[MAX_DICTIONARIES][256];
+	set0(words);
+	int lineNos[MAX_DICTIONARIES];
+	set0(lineNos);
+	int has_word[MAX_DICTIONARIES];
+	
+	for (int i=0; i<dict_count; i++) {
+		assert(dicts[i]);
+		has_word[i] = _read_next_word(dicts[i], words[i], sizeof(words[i]), &lineNos[i]);
+	}
 	
 	struct vertex * root = _new_node(0, 0, &context);
-	int lineNo = 0;
-	while (fgets(word, sizeof(word), dict)) {
-		if (word[strlen(word) - 1] != '\n' && !feof(dict)) { // word was too long
-			fprintf(stderr, "Skipping line %d. Word is longer than %d characters\n", lineNo, WORD_LIMIT);
-			do {
-				fgets(word, sizeof(word), dict);
-			} while (word[strlen(word) - 1] != '\n');
-			continue;
-		}
-		lineNo++;
-		for (int i=0; word[i]; i++) {
-			if (isspace(word[i])) {
-				word[i] = '\0';
-			} else if (isupper(word[i])) {
-				word[i] = tolower(word[i]);
-			} else if (!islower(word[i])) {
-				fprintf(stderr, "Skipping line %d: \"%s\". Illegal character '%c' at position %d\n", lineNo, word, word[i], i);
+	while (1) {
+		char * word = 0;
+		for (int i=0; i<dict_count; i++) {
+			if (has_word[i] && (!word || strcmp(words[i], word) < 0)) {
+				word = words[i];
 			}
 		}
-		if (strlen(word) > WORD_LIMIT) {
-			fprintf(stderr, "Skipping line %d: \"%s\". Word is longer than %d characters\n", lineNo, word, WORD_LIMIT);
-			continue;
+		if (!word) {
+			break;
 		}
-		assert(strlen(word) <= 16);
-		_add_word_to_dawg(root, word, last_word, &context);
+		char next_word[WORD_BUFF_SIZE];
+		strcpy(next_word, word);
+		unsigned int word_mask = 0;
+		for (int i=0; i<dict_count; i++) {
+			if (has_word[i] && strcmp(words[i], next_word) == 0) {
+				word_mask |= 1u << i;
+				has_word[i] = _read_next_word(dicts[i], words[i], sizeof(words[i]), &lineNos[i]);
+			}
+		}
+		assert(strlen(next_word) <= 16);
+		_add_word_to_dawg(root, next_word, last_word, word_mask, &context);
 	}
 	
 	fprintf(stderr, "Created trie with %d vertices/edges\n", context.vertex_count);
@@ -253,7 +311,7 @@ struct dawg * dawg_from_word_file(FILE *dict) {
 			context.vertex_count, 100 - ((context.vertex_count * 100) / trie_node_count),
 			context.edge_count, 100 - ((context.edge_count * 100) / trie_node_count));
 	
-	struct dawg * dawg = calloc(1, sizeof(struct dawg *));
+	struct dawg * dawg = calloc(1, sizeof(struct dawg));
 	dawg->node_count = context.vertex_count;
 	dawg->root = root;
 	
@@ -313,6 +371,135 @@ void _flatten_vertices(struct vertex * node, struct vertex ** nodes, int node_co
 
 #define MAX_VERTEX_BINARY_SIZE 4
 
+// encode the edge leading to edge_to as a 32 bit integer. edge_to->file_offset must already be set
+unsigned int _binary_edge(struct vertex * edge_to, int is_last) {
+	unsigned int edge_int = 0;
+	if (edge_to->is_word) {
+		edge_int |= WORD_BIT;
+	}
+	if (is_last) {
+		edge_int |= LAST_SIBLING_BIT;
+	}
+	assert(edge_to->value <= 0x1F); // value fits in 5 bits
+	edge_int |= edge_to->value << 24; // store value in bits 4-8
+	if (edge_to->edge_count) {
+		assert(edge_to->file_offset <= 0x00FFFFFF); // offset fits in 24 bits
+		edge_int |= edge_to->file_offset; // store offset in bits 9-32;
+	}
+	return edge_int;
+}
+
+//
+// EMBEDDED SOURCE GENERATION
+//
+
+// When a DAWG is written as text, the output is a C/C++ header containing the edge table and
+// functions for looking up words in it. The table is static const and aligned to a cache line so
+// that it lives in read only memory shared between processes. The first EMBED_SWITCH_DEPTH letters
+// of a word are looked up with nested switch statements with the edges hard-wired into them, so
+// the compiler can turn them into jump tables, and only the remaining letters use the generic
+// sibling scan. When compiled as C++14 or later, the table and functions are constexpr.
+
+#define EMBED_SWITCH_DEPTH 2
+
+#define _stringify(x) #x
+#define stringify(x) _stringify(x)
+
+void _write_embed_header(FILE * out) {
+	fprintf(out, "/*\n * Generated by dawgc --embed. Do not edit.\n */\n\n");
+	fprintf(out, "#ifndef dawg_table_h_included\n#define dawg_table_h_included\n\n");
+	fprintf(out, "#include <stdint.h>\n\n");
+	fprintf(out, "#if defined(__cplusplus) && __cplusplus >= 201402L\n");
+	fprintf(out, "#define DAWG_CONST static constexpr\n#define DAWG_FUNC static constexpr\n");
+	fprintf(out, "#else\n");
+	fprintf(out, "#define DAWG_CONST static const\n#define DAWG_FUNC static inline\n");
+	fprintf(out, "#endif\n\n");
+	fprintf(out, "#if defined(__cplusplus)\n#define DAWG_ALIGN alignas(64)\n");
+	fprintf(out, "#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L\n#define DAWG_ALIGN _Alignas(64)\n");
+	fprintf(out, "#elif defined(__GNUC__)\n#define DAWG_ALIGN __attribute__((aligned(64)))\n");
+	fprintf(out, "#else\n#define DAWG_ALIGN\n#endif\n\n");
+	fprintf(out, "#define DAWG_CHAR_TO_INDEX(c) (%s)\n\n", stringify(char_to_index(c)));
+	fprintf(out, "DAWG_ALIGN DAWG_CONST uint32_t DAWG_TABLE[] = {");
+}
+
+void _write_embed_indent(FILE * out, int depth) {
+	for (int i=0; i<depth; i++) {
+		fprintf(out, "\t");
+	}
+}
+
+// write a switch on word[depth] that selects between the edges of node
+void _write_embed_switch(struct vertex * node, int depth, FILE * out) {
+	int indent = depth + 1;
+	_write_embed_indent(out, indent);
+	fprintf(out, "switch (word[%d]) {\n", depth);
+	if (depth > 0) {
+		// the word ends at the edge leading to node, which the caller passes in as "edge"
+		_write_embed_indent(out, indent);
+		fprintf(out, "case '\\0': return edge;\n");
+	}
+	int children = 0;
+	for (int i=0; i<LETTER_COUNT; i++) {
+		struct vertex * edge_to = node->edges[i];
+		if (!edge_to) {
+			continue;
+		}
+		children++;
+		unsigned int edge_int = _binary_edge(edge_to, children == node->edge_count);
+		_write_embed_indent(out, indent);
+		fprintf(out, "case '%c':\n", index_to_char(i));
+		_write_embed_indent(out, indent + 1);
+		fprintf(out, "edge = 0x%08X;\n", edge_int);
+		if (depth + 1 < EMBED_SWITCH_DEPTH) {
+			if (edge_to->edge_count) {
+				_write_embed_switch(edge_to, depth + 1, out);
+			} else {
+				_write_embed_indent(out, indent + 1);
+				fprintf(out, "return word[%d] ? 0 : edge;\n", depth + 1);
+			}
+		}
+		_write_embed_indent(out, indent + 1);
+		fprintf(out, "break;\n");
+	}
+	_write_embed_indent(out, indent);
+	fprintf(out, "default:\n");
+	_write_embed_indent(out, indent + 1);
+	fprintf(out, "return 0;\n");
+	_write_embed_indent(out, indent);
+	fprintf(out, "}\n");
+}
+
+void _write_embed_lookup(struct dawg * dawg, FILE * out) {
+	fprintf(out, "\n\n// follow the path of word through the graph and return the last edge on it, or 0 if there is no\n");
+	fprintf(out, "// such path. Edges are encoded as per dawg-file-traversal.h\n");
+	fprintf(out, "DAWG_FUNC uint32_t dawg_follow(const char * word) {\n");
+	fprintf(out, "\tuint32_t edge = 0;\n");
+	_write_embed_switch(dawg->root, 0, out);
+	fprintf(out, "\tfor (int i=%d; word[i]; i++) {\n", EMBED_SWITCH_DEPTH);
+	fprintf(out, "\t\tuint32_t offset = edge & 0x00FFFFFF;\n");
+	fprintf(out, "\t\tif (!offset) return 0;\n");
+	fprintf(out, "\t\tfor (;; offset++) {\n");
+	fprintf(out, "\t\t\tuint32_t sibling = DAWG_TABLE[offset];\n");
+	fprintf(out, "\t\t\tif (((sibling >> 24) & 0x1F) == (uint32_t) DAWG_CHAR_TO_INDEX(word[i])) {\n");
+	fprintf(out, "\t\t\t\tedge = sibling;\n");
+	fprintf(out, "\t\t\t\tbreak;\n");
+	fprintf(out, "\t\t\t}\n");
+	fprintf(out, "\t\t\tif (sibling & 0x%08X) return 0;\n", LAST_SIBLING_BIT);
+	fprintf(out, "\t\t}\n");
+	fprintf(out, "\t}\n");
+	fprintf(out, "\treturn edge;\n");
+	fprintf(out, "}\n\n");
+	fprintf(out, "// returns 1 if word is in the dictionary, otherwise 0\n");
+	fprintf(out, "DAWG_FUNC int dawg_contains(const char * word) {\n");
+	fprintf(out, "\treturn (dawg_follow(word) & 0x%08X) ? 1 : 0;\n", WORD_BIT);
+	fprintf(out, "}\n\n");
+	fprintf(out, "// returns 1 if at least one word in the dictionary starts with prefix, otherwise 0\n");
+	fprintf(out, "DAWG_FUNC int dawg_has_prefix(const char * prefix) {\n");
+	fprintf(out, "\treturn dawg_follow(prefix) ? 1 : 0;\n");
+	fprintf(out, "}\n\n");
+	fprintf(out, "#endif\n");
+}
+
 
 // write a DAWG to a file
 void binary_file_from_dawg(struct dawg * dawg, FILE * out, int text) {
@@ -331,7 +518,7 @@ void binary_file_from_dawg(struct dawg * dawg, FILE * out, int text) {
 		file_offset += nodes[i]->edge_count;
 	}
 	
-	if (text) fprintf(out, "int DAWG_TABLE[] = {");
+	if (text) _write_embed_header(out);
 	for (int i=0; i<node_count; i++) {
 		struct vertex * node = nodes[i];
 		assert(node);
@@ -344,19 +531,7 @@ void binary_file_from_dawg(struct dawg * dawg, FILE * out, int text) {
 			struct vertex * edge_to = node->edges[j];
 			if (edge_to) {
 				children++;
-				unsigned int edge_int = 0;
-				if (edge_to->is_word) {
-					edge_int |= WORD_BIT;
-				}
-				if (children == node->edge_count) {
-					edge_int |= LAST_SIBLING_BIT;
-				}
-				assert(edge_to->value <= 0x1F); // value fits in 5 bits
-				edge_int |= edge_to->value << 24; // store value in bits 4-8
-				if (edge_to->edge_count) {
-					assert(edge_to->file_offset <= 0x00FFFFFF); // offset fits in 24 bits
-					edge_int |= edge_to->file_offset; // store offset in bits 9-32;
-				}
+				unsigned int edge_int = _binary_edge(edge_to, children == node->edge_count);
 				if (text) {
 					fprintf(out, "0x%08X, ", edge_int);
 				} else {
@@ -366,13 +541,79 @@ void binary_file_from_dawg(struct dawg * dawg, FILE * out, int text) {
 			}
 		}
 	}
-	if (text) fprintf(out, "\n};");
+	if (text) {
+		fprintf(out, "\n};");
+		_write_embed_lookup(dawg, out);
+	}
 	
 	//	_do_write_cdawg(dawg->root, out, &counter);
 	
 	free(nodes);
 }
 
+//
+// MULTI-DICTIONARY BINARY FILE GENERATION
+//
+
+// A dawg compiled from several word files is written as the edge count, then the edges exactly as
+// binary_file_from_dawg writes them, then two arrays with one bitmask for each edge:
+//
+// word masks: the dictionaries that contain the word ending at the edge
+// reach masks: the dictionaries that contain any word whose path passes through the edge, which
+//              lets a lookup in a single dictionary stop as soon as it leaves that dictionary
+
+unsigned int _calculate_reach_mask(struct vertex * node, unsigned int * reach_masks, unsigned char * done) {
+	if (done[node->id]) {
+		return reach_masks[node->id];
+	}
+	unsigned int mask = node->word_mask;
+	for (int i=0; i<LETTER_COUNT; i++) {
+		if (node->edges[i]) {
+			mask |= _calculate_reach_mask(node->edges[i], reach_masks, done);
+		}
+	}
+	reach_masks[node->id] = mask;
+	done[node->id] = 1;
+	return mask;
+}
+
+void multi_binary_file_from_dawg(struct dawg * dawg, FILE * out) {
+	assert(out);
+	
+	int node_count = dawg->node_count;
+	struct vertex ** nodes = calloc(node_count, sizeof(struct vertex *));
+	_flatten_vertices(dawg->root, nodes, node_count);
+	
+	unsigned int * reach_masks = calloc(node_count, sizeof(unsigned int));
+	unsigned char * done = calloc(node_count, sizeof(unsigned char));
+	_calculate_reach_mask(dawg->root, reach_masks, done);
+	
+	unsigned int edge_count = 0;
+	for (int i=0; i<node_count; i++) {
+		edge_count += nodes[i]->edge_count;
+	}
+	fwrite(&edge_count, sizeof(edge_count), 1, out);
+	
+	binary_file_from_dawg(dawg, out, 0);
+	
+	// masks are written in the same order as binary_file_from_dawg writes edges
+	for (int reach=0; reach<2; reach++) {
+		for (int i=0; i<node_count; i++) {
+			for (int j=0; j<LETTER_COUNT; j++) {
+				struct vertex * edge_to = nodes[i]->edges[j];
+				if (edge_to) {
+					unsigned int mask = reach ? reach_masks[edge_to->id] : edge_to->word_mask;
+					fwrite(&mask, sizeof(mask), 1, out);
+				}
+			}
+		}
+	}
+	
+	free(done);
+	free(reach_masks);
+	free(nodes);
+}
+
 //
 // BINARY FILE DECOMPILATION
 //
@@ -398,8 +639,8 @@ void _add_binary_node_to_dawg(unsigned int * binary_node, int offset, struct ver
 	} while (!is_last_edge(edge));
 }
 
-struct vertex * trie_from_binary_file(FILE * in) {
-	// copy file to buffer
+// read the whole of a binary file into a buffer of edges
+unsigned int * _read_binary_file(FILE * in, int * edge_count) {
 	int buffer_size = 256*256, total_read = 0;
 	unsigned int * buffer = malloc(buffer_size * sizeof(unsigned int));
 	do {
@@ -412,6 +653,14 @@ struct vertex * trie_from_binary_file(FILE * in) {
 			buffer = new_buffer;
 		}
 	} while (!feof(in));
+	*edge_count = total_read;
+	return buffer;
+}
+
+struct vertex * trie_from_binary_file(FILE * in) {
+	// copy file to buffer
+	int total_read;
+	unsigned int * buffer = _read_binary_file(in, &total_read);
 	/*
 	
 	unsigned int node_counter = 0, total_nodes;
@@ -453,6 +702,348 @@ struct vertex * trie_from_binary_file(FILE * in) {
 	return root;
 }
 
+//
+// INCREMENTAL UPDATES
+//
+
+// A compiled dawg can be updated without recompiling the whole word list. The binary file is loaded
+// with its shared vertices still shared, and a register (hash table of unique vertices) is built from
+// the existing vertices. Then each added or removed word is applied by:
+// 1. Walking the path of the word from the root, taking each vertex on it out of the register and
+//    cloning any confluence vertex (one with more than one parent) so that the change doesn't
+//    affect other words that share it
+// 2. Setting or clearing the word flag at the end of the path, adding vertices for a new suffix or
+//    pruning vertices that no longer lead to a word
+// 3. Walking back up the path, merging each vertex with an equal vertex from the register if one
+//    exists, or registering it if not
+// Only vertices on the path of a changed word are touched, so the cost of an update is
+// proportional to the number of words changed rather than the size of the dictionary.
+
+#define REGISTER_TOMBSTONE ((struct vertex *) 1)
+
+// find a vertex in the register that is equal to node, or 0 if there isn't one
+struct vertex * _register_find(struct vertex * node, struct _dawg_context * context) {
+	int pos = node->hashcode % context->register_size;
+	while (context->vertex_register[pos]) {
+		struct vertex * other = context->vertex_register[pos];
+		if (other != REGISTER_TOMBSTONE && nodes_are_equal(node, other)) {
+			return other;
+		}
+		pos = (pos + 1) % context->register_size;
+	}
+	return 0;
+}
+
+void _register_resize(int size, struct _dawg_context * context) {
+	struct vertex ** old_register = context->vertex_register;
+	int old_size = context->register_size;
+	context->vertex_register = calloc(size, sizeof(struct vertex *));
+	context->register_size = size;
+	context->register_used = 0;
+	for (int i=0; i<old_size; i++) {
+		struct vertex * node = old_register[i];
+		if (node && node != REGISTER_TOMBSTONE) {
+			int pos = node->hashcode % size;
+			while (context->vertex_register[pos]) {
+				pos = (pos + 1) % size;
+			}
+			context->vertex_register[pos] = node;
+			context->register_used++;
+		}
+	}
+	free(old_register);
+}
+
+void _register_add(struct vertex * node, struct _dawg_context * context) {
+	if ((context->register_used + 1) * 3 > context->register_size * 2) {
+		_register_resize(context->vertex_count * 3 + 1, context);
+	}
+	int pos = node->hashcode % context->register_size;
+	while (context->vertex_register[pos] && context->vertex_register[pos] != REGISTER_TOMBSTONE) {
+		pos = (pos + 1) % context->register_size;
+	}
+	if (!context->vertex_register[pos]) {
+		context->register_used++;
+	}
+	context->vertex_register[pos] = node;
+}
+
+// remove node from the register if it is there. Its hashcode must not have changed since it was added
+void _register_remove(struct vertex * node, struct _dawg_context * context) {
+	int pos = node->hashcode % context->register_size;
+	while (context->vertex_register[pos]) {
+		if (context->vertex_register[pos] == node) {
+			context->vertex_register[pos] = REGISTER_TOMBSTONE;
+			return;
+		}
+		pos = (pos + 1) % context->register_size;
+	}
+}
+
+// remove an incoming edge from node, freeing it and releasing its own edges if that was the last one
+void _release_vertex(struct vertex * node, struct _dawg_context * context) {
+	assert(node->parent_count > 0);
+	if (--node->parent_count > 0) {
+		return;
+	}
+	_register_remove(node, context);
+	for (int i=0; i<LETTER_COUNT; i++) {
+		if (node->edges[i]) {
+			_release_vertex(node->edges[i], context);
+		}
+	}
+	free(node);
+	context->vertex_count--;
+}
+
+struct vertex * _clone_vertex(struct vertex * node, struct _dawg_context * context) {
+	struct vertex * clone = malloc(sizeof(struct vertex));
+	memcpy(clone, node, sizeof(struct vertex));
+	clone->parent_count = 1;
+	for (int i=0; i<LETTER_COUNT; i++) {
+		if (clone->edges[i]) {
+			clone->edges[i]->parent_count++;
+		}
+	}
+	context->vertex_count++;
+	return clone;
+}
+
+// add every vertex reachable from node to nodes in post-order, so that each vertex comes after all
+// of its descendants. Sets node->visited, which the caller must clear.
+void _collect_vertices_post_order(struct vertex * node, struct vertex ** nodes, int * count) {
+	if (node->visited) {
+		return;
+	}
+	node->visited = 1;
+	for (int i=0; i<LETTER_COUNT; i++) {
+		if (node->edges[i]) {
+			_collect_vertices_post_order(node->edges[i], nodes, count);
+		}
+	}
+	nodes[(*count)++] = node;
+}
+
+// give the vertices of a dawg consecutive ids so that no vertex has an id lower than any of its
+// parents, and count the vertices and edges
+void _renumber_vertices(struct dawg * dawg, struct _dawg_context * context) {
+	struct vertex ** nodes = calloc(context->vertex_count, sizeof(struct vertex *));
+	int count = 0;
+	_collect_vertices_post_order(dawg->root, nodes, &count);
+	assert(count == context->vertex_count);
+	context->edge_count = 0;
+	for (int i=0; i<count; i++) {
+		nodes[i]->visited = 0;
+		nodes[i]->id = count - i - 1;
+		context->edge_count += nodes[i]->edge_count;
+	}
+	dawg->node_count = count;
+	free(nodes);
+}
+
+struct vertex * _vertex_from_binary_edge(unsigned int * buffer, unsigned int edge, int total_read,
+										 struct vertex ** nodes_by_offset, struct vertex ** leaves,
+										 struct _dawg_context * context) {
+	unsigned char value = edge_value(edge);
+	unsigned char is_word = is_word_edge(edge);
+	int offset = edge_offset(edge);
+	
+	// vertices with no edges are stored in the file as an offset of 0, so they are identified
+	// by their value and word flag instead
+	struct vertex ** existing = offset ? &nodes_by_offset[offset] : &leaves[value * 2 + is_word];
+	if (*existing) {
+		assert((*existing)->value == value && (*existing)->is_word == is_word);
+		(*existing)->parent_count++;
+		return *existing;
+	}
+	
+	struct vertex * node = _new_node(value, 0, context);
+	node->is_word = is_word;
+	node->word_mask = is_word;
+	node->parent_count = 1;
+	*existing = node;
+	if (offset) {
+		unsigned int i=0, child_edge;
+		do {
+			assert(offset + i < total_read);
+			child_edge = buffer[offset + i];
+			struct vertex * child = _vertex_from_binary_edge(buffer, child_edge, total_read, nodes_by_offset, leaves, context);
+			assert(!node->edges[child->value]);
+			node->edges[child->value] = child;
+			node->edge_count++;
+			i++;
+		} while (!is_last_edge(child_edge));
+	}
+	return node;
+}
+
+struct dawg * dawg_from_binary_file(FILE * in) {
+	assert(in);
+	
+	struct _dawg_context context;
+	memset(&context, 0, sizeof(context));
+	
+	int total_read;
+	unsigned int * buffer = _read_binary_file(in, &total_read);
+	struct vertex ** nodes_by_offset = calloc(total_read, sizeof(struct vertex *));
+	struct vertex * leaves[LETTER_COUNT * 2];
+	set0(leaves);
+	
+	struct vertex * root = _new_node(0, 0, &context);
+	unsigned int i=0, edge;
+	while (i < total_read) {
+		edge = buffer[i];
+		struct vertex * child = _vertex_from_binary_edge(buffer, edge, total_read, nodes_by_offset, leaves, &context);
+		root->edges[child->value] = child;
+		root->edge_count++;
+		i++;
+		if (is_last_edge(edge)) break;
+	}
+	
+	struct dawg * dawg = calloc(1, sizeof(struct dawg));
+	dawg->root = root;
+	_renumber_vertices(dawg, &context);
+	
+	free(nodes_by_offset);
+	free(buffer);
+	return dawg;
+}
+
+// returns 1 if word is in the dawg, otherwise 0
+int _dawg_contains_word(struct vertex * root, const char * word) {
+	struct vertex * node = root;
+	for (int i=0; word[i]; i++) {
+		node = node->edges[char_to_index(word[i])];
+		if (!node) {
+			return 0;
+		}
+	}
+	return node->is_word;
+}
+
+// add (is_word = 1) or remove (is_word = 0) a single word
+void _set_word_in_dawg(struct vertex * root, const char * word, unsigned char is_word, struct _dawg_context * context) {
+	int len = strlen(word);
+	if (len == 0 || _dawg_contains_word(root, word) == is_word) {
+		return;
+	}
+	
+	// walk down the path, separating it from the rest of the dawg
+	struct vertex * path[WORD_BUFF_SIZE];
+	path[0] = root;
+	int depth;
+	for (depth=0; depth<len; depth++) {
+		struct vertex * parent = path[depth];
+		int index = char_to_index(word[depth]);
+		struct vertex * node = parent->edges[index];
+		if (!node) {
+			break;
+		}
+		if (node->parent_count > 1) {
+			node->parent_count--;
+			node = _clone_vertex(node, context);
+			parent->edges[index] = node;
+		} else {
+			_register_remove(node, context);
+		}
+		path[depth + 1] = node;
+	}
+	
+	// add new vertices for the rest of the word
+	for (; depth<len; depth++) {
+		int index = char_to_index(word[depth]);
+		struct vertex * node = _new_node(index, 0, context);
+		node->parent_count = 1;
+		path[depth]->edges[index] = node;
+		path[depth]->edge_count++;
+		path[depth + 1] = node;
+	}
+	path[len]->is_word = is_word;
+	path[len]->word_mask = is_word;
+	
+	// prune vertices that no longer lead to any word
+	int top = len;
+	while (top > 0 && !path[top]->is_word && path[top]->edge_count == 0) {
+		path[top - 1]->edges[path[top]->value] = 0;
+		path[top - 1]->edge_count--;
+		free(path[top]);
+		context->vertex_count--;
+		top--;
+	}
+	
+	// walk back up the path, replacing vertices with equivalent registered ones
+	for (int i=top; i>0; i--) {
+		struct vertex * node = path[i];
+		_calculate_hashcode(node);
+		struct vertex * sole_node = _register_find(node, context);
+		if (sole_node) {
+			path[i - 1]->edges[node->value] = sole_node;
+			sole_node->parent_count++;
+			_release_vertex(node, context);
+		} else {
+			_register_add(node, context);
+		}
+	}
+}
+
+void _set_words_from_file(struct vertex * root, FILE * in, unsigned char is_word, struct _dawg_context * context) {
+	char word[256];
+	set0(word);
+	int lineNo = 0, result;
+	while ((result = _read_word(in, word, sizeof(word), &lineNo))) {
+		if (result > 0) {
+			_set_word_in_dawg(root, word, is_word, context);
+		}
+	}
+}
+
+void update_dawg(struct dawg * dawg, FILE * added, FILE * removed) {
+	struct _dawg_context context;
+	memset(&context, 0, sizeof(context));
+	
+	// rebuild the register and parent counts from the existing vertices
+	struct vertex ** nodes = calloc(dawg->node_count, sizeof(struct vertex *));
+	int count = 0;
+	_collect_vertices_post_order(dawg->root, nodes, &count);
+	context.vertex_count = count;
+	context.register_size = count * 3 + 1;
+	context.vertex_register = calloc(context.register_size, sizeof(struct vertex *));
+	for (int i=0; i<count; i++) {
+		nodes[i]->visited = 0;
+		nodes[i]->parent_count = 0;
+	}
+	for (int i=0; i<count; i++) {
+		for (int j=0; j<LETTER_COUNT; j++) {
+			if (nodes[i]->edges[j]) {
+				nodes[i]->edges[j]->parent_count++;
+			}
+		}
+		if (nodes[i] != dawg->root) {
+			_calculate_hashcode(nodes[i]);
+			if (!_register_find(nodes[i], &context)) {
+				_register_add(nodes[i], &context);
+			}
+		}
+	}
+	free(nodes);
+	
+	if (removed) {
+		_set_words_from_file(dawg->root, removed, 0, &context);
+	}
+	if (added) {
+		_set_words_from_file(dawg->root, added, 1, &context);
+	}
+	
+	int original_node_count = dawg->node_count;
+	_renumber_vertices(dawg, &context);
+	
+	fprintf(stderr, "Updated DAWG from %d to %d vertices with %d edges\n",
+			original_node_count, dawg->node_count, context.edge_count);
+	
+	free(context.vertex_register);
+}
+
+
 //
 // GRAPH VISUALISATION
 //
@@ -17,6 +17,9 @@
 #define LETTER_COUNT 26
 #endif
 
+// Maximum number of dictionaries that can share a DAWG, one per bit of vertex.word_mask
+#define MAX_DICTIONARIES 32
+
 // convert a character into an index. Should produce value from 0 to LETTER_COUNT-1
 #ifndef char_to_index
 #define char_to_index(c) c - 'a'
@@ -31,12 +34,14 @@
 struct vertex {
 	int id; // unique name and order of node in binary file
 	unsigned char is_word; // whether a word ends at this node
+	unsigned int word_mask; // bitmask of the dictionaries that contain the word ending at this node
 	unsigned char value; // the value of this node
 	unsigned char edge_count; // number of outgoing edges
 	unsigned char visited; // used to prevent double-visiting during graph traversal
 	unsigned char leaf_distance; // length of shortest path from this vertex to a leaf
 	unsigned int hashcode;
 	struct vertex * trie_parent; // original parent in trie phase, before conversion to a DAWG
+	unsigned int parent_count; // number of incoming edges, maintained while updating a DAWG
 	struct vertex * edges[LETTER_COUNT]; // outgoing edges, sorted by letter
 	
 	unsigned int file_offset; // position in the dawg file
@@ -50,12 +55,28 @@ struct dawg {
 // compile a word file into a dawg
 struct dawg * dawg_from_word_file(FILE *dict);
 
+// compile several word files into one dawg, recording which of them contain each word in
+// vertex.word_mask. Bit N of the mask represents dicts[N]
+struct dawg * dawg_from_word_files(FILE ** dicts, int dict_count);
+
 // decompile a binary file into a dawg
 struct vertex * trie_from_binary_file(FILE *binary);
 
-// write a dawg to a file in the compressed binary format
+// load a binary file into a dawg, keeping shared vertices shared so that it can be updated
+struct dawg * dawg_from_binary_file(FILE *binary);
+
+// add and remove words from a dawg without recompiling it. Each file contains one word per line
+// in any order, and either may be null. Removals are applied before additions.
+void update_dawg(struct dawg * dawg, FILE * added, FILE * removed);
+
+// write a dawg to a file in the compressed binary format, or if text is 1 as a C/C++ header
+// containing the binary data and functions for looking up words in it
 void binary_file_from_dawg(struct dawg * root, FILE * out, int text);
 
+// write a dawg compiled from several word files to a file in the multi-dictionary binary format
+// (see multi-dawg.h)
+void multi_binary_file_from_dawg(struct dawg * dawg, FILE * out);
+
 // decompile a DAWG or TRIE into a word file
 void print_word_file(struct vertex * root, FILE * out);
 